@@ -0,0 +1,62 @@
+//
+// Compares parsing throughput of checked and unchecked loads.
+//
+//   parse_bench [iterations] <file.obj>...
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Model.h"
+
+namespace {
+double MegabytesPerSecond(const std::vector<std::string>& files,
+                          int iterations, const s21::ObjLimits* limits) {
+  size_t bytes = 0, vertexes = 0;
+  const auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    for (const auto& data : files) {
+      vertexes += s21::ObjLoader::Parse(data, limits).vertexes.size();
+      bytes += data.size();
+    }
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - begin)
+                             .count();
+  if (vertexes == 0) std::cerr << "no vertexes parsed\n";
+  return (double)bytes / (1024 * 1024) / seconds;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int first = 1, iterations = 20;
+  if (argc > 1 && std::isdigit((unsigned char)argv[1][0])) {
+    iterations = std::stoi(argv[1]);
+    first = 2;
+  }
+  std::vector<std::string> files;
+  for (int i = first; i < argc; ++i) {
+    std::ifstream file(argv[i], std::ios::binary);
+    std::stringstream buf;
+    buf << file.rdbuf();
+    files.push_back(buf.str());
+  }
+  if (files.empty()) {
+    std::cerr << "Usage: " << argv[0] << " [iterations] <file.obj>...\n";
+    return 2;
+  }
+
+  const s21::ObjLimits limits;
+  MegabytesPerSecond(files, 1, nullptr);
+  const double unchecked = MegabytesPerSecond(files, iterations, nullptr);
+  const double checked = MegabytesPerSecond(files, iterations, &limits);
+  std::cout << "unchecked: " << unchecked << " MB/s\n"
+            << "checked:   " << checked << " MB/s ("
+            << (checked / unchecked - 1) * 100 << "%)\n";
+  return 0;
+}
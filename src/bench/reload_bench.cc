@@ -0,0 +1,155 @@
+//
+// Measures reload latency for small edits to a large OBJ file, then checks
+// that reloads after random edits match a fresh load.
+//
+//   reload_bench [grid size] [iterations] [checked edits]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "Model.h"
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+
+double Milliseconds(clock_type::time_point begin) {
+  return std::chrono::duration<double, std::milli>(clock_type::now() - begin)
+      .count();
+}
+
+std::string MakeGrid(int size, int edited_row, float height) {
+  std::ostringstream out;
+  for (int i = 0; i < size; ++i) {
+    for (int j = 0; j < size; ++j) {
+      float z = i == edited_row && j == size / 2 ? height : 0.0f;
+      out << "v " << (float)i / (float)size << ' ' << (float)j / (float)size
+          << ' ' << z << '\n';
+    }
+  }
+  for (int i = 0; i + 1 < size; ++i) {
+    for (int j = 0; j + 1 < size; ++j) {
+      int a = i * size + j + 1;
+      out << "f " << a << ' ' << a + 1 << ' ' << a + size + 1 << ' '
+          << a + size << '\n';
+    }
+  }
+  return out.str();
+}
+
+void Write(const std::string& path, const std::string& data) {
+  std::ofstream file(path, std::ios::trunc);
+  file << data;
+}
+
+/**
+ * Replaces, removes, duplicates or inserts a line at a random position.
+ */
+void Edit(std::string& data, std::mt19937& rng) {
+  size_t begin = data.rfind('\n', rng() % data.size());
+  begin = begin == std::string::npos ? 0 : begin + 1;
+  size_t end = data.find('\n', begin);
+  end = end == std::string::npos ? data.size() : end + 1;
+  const std::string line = data.substr(begin, end - begin);
+  switch (rng() % 5) {
+    case 0:
+      data.replace(begin, end - begin,
+                   "v " + std::to_string((int)(rng() % 100) - 50) + " " +
+                       std::to_string((float)(rng() % 1000) / 1000) + " 0\n");
+      break;
+    case 1:
+      data.erase(begin, end - begin);
+      break;
+    case 2:
+      data.insert(begin, line);
+      break;
+    case 3:
+      data.insert(begin, "# comment\n");
+      break;
+    default:
+      if (line.size() > 3) data[begin + 2 + rng() % (line.size() - 3)] = '7';
+      break;
+  }
+  if (data.empty()) data = "v 0 0 0\n";
+}
+
+bool SameChunks(const s21::chunks_type& a, const s21::chunks_type& b) {
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                    [](const s21::ObjChunk& x, const s21::ObjChunk& y) {
+                      return x.hash == y.hash &&
+                             x.vertexes_begin == y.vertexes_begin &&
+                             x.vertexes_count == y.vertexes_count &&
+                             x.facets_begin == y.facets_begin &&
+                             x.facets_count == y.facets_count &&
+                             x.lines == y.lines &&
+                             x.max == y.max;
+                    });
+}
+
+/**
+ * Applies random edits one after another and compares every reload with a
+ * fresh load of the same file.
+ * @return Number of mismatches.
+ */
+size_t Check(const std::string& path, int edits, size_t& patched) {
+  std::mt19937 rng(42);
+  std::string data = MakeGrid(40, 20, 0.5f);
+  Write(path, data);
+  s21::Obj obj = s21::ObjLoader::Load(path);
+  size_t mismatches = 0;
+  for (int i = 0; i < edits; ++i) {
+    Edit(data, rng);
+    Write(path, data);
+    s21::ObjDelta delta = s21::ObjLoader::Reload(path, obj);
+    s21::Obj expected = s21::ObjLoader::Load(path);
+    if (!delta.full) ++patched;
+    if (obj.vertexes != expected.vertexes || obj.facets != expected.facets ||
+        obj.max != expected.max || !SameChunks(obj.chunks, expected.chunks)) {
+      ++mismatches;
+      obj = expected;
+    }
+  }
+  return mismatches;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const int size = argc > 1 ? std::stoi(argv[1]) : 400;
+  const int iterations = argc > 2 ? std::stoi(argv[2]) : 20;
+  const int edits = argc > 3 ? std::stoi(argv[3]) : 2000;
+  const std::string path = "reload_bench.obj";
+
+  Write(path, MakeGrid(size, size / 2, 0.0f));
+  auto begin = clock_type::now();
+  s21::Obj obj = s21::ObjLoader::Load(path);
+  double load_ms = Milliseconds(begin);
+
+  double reload_ms = 0;
+  size_t patched = 0;
+  for (int i = 0; i < iterations; ++i) {
+    Write(path, MakeGrid(size, size / 2, 0.25f * (float)(i % 3)));
+    begin = clock_type::now();
+    s21::ObjDelta delta = s21::ObjLoader::Reload(path, obj);
+    reload_ms += Milliseconds(begin);
+    if (!delta.full) ++patched;
+  }
+
+  std::cout << "vertexes: " << obj.vertexes.size() / 3
+            << ", chunks: " << obj.chunks.size() << '\n'
+            << "full load: " << load_ms << " ms\n"
+            << "reload after edit: " << reload_ms / iterations << " ms ("
+            << patched << '/' << iterations << " patched)\n";
+
+  patched = 0;
+  const size_t mismatches = Check(path, edits, patched);
+  std::remove(path.c_str());
+  std::cout << "random edits: " << edits << ", patched: " << patched
+            << ", mismatches: " << mismatches << '\n';
+  return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+//
+// Replays a recorded input trace against a model and reports frame times.
+//
+// Record a trace by running the viewer with S21_INPUT_RECORD=<file>, then:
+//   replay_bench <trace> <model.obj> [budget ms]
+//
+
+#include <QApplication>
+#include <QTimer>
+#include <iostream>
+
+#include "Controller.h"
+#include "InputTrace.h"
+#include "Model.h"
+#include "OpenGLWidget.h"
+
+int main(int argc, char* argv[]) {
+  QSurfaceFormat format;
+  format.setVersion(4, 1);
+  format.setProfile(QSurfaceFormat::CoreProfile);
+  QSurfaceFormat::setDefaultFormat(format);
+
+  QApplication app(argc, argv);
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <trace> <model.obj>\n";
+    return 2;
+  }
+  const auto events = InputTrace::Load(argv[1]);
+  if (events.empty()) {
+    std::cerr << "Empty trace: " << argv[1] << '\n';
+    return 1;
+  }
+
+  s21::Model model;
+  s21::Controller controller(model);
+  controller.LoadOBJ(argv[2]);
+
+  OpenGLWidget widget;
+  widget.resize(800, 600);
+  widget.show();
+  while (!widget.isValid()) QApplication::processEvents();
+  widget.SetVertexes(&controller.Vertexes());
+  widget.SetFacets(&controller.Facets());
+  widget.makeCurrent();
+  widget.LoadDataToBuffers();
+  widget.doneCurrent();
+  widget.update();
+
+  for (const auto& event : events) {
+    QTimer::singleShot(event.time, &widget, [&widget, event]() {
+      QMouseEvent mouse(event.type, event.position,
+                        widget.mapToGlobal(event.position), event.button,
+                        event.buttons, Qt::NoModifier);
+      QApplication::sendEvent(&widget, &mouse);
+    });
+  }
+  QTimer::singleShot(events.back().time + 500, &app, [&]() {
+    const auto& stats = widget.Scheduler().Stats();
+    const double duration = (double)events.back().time / 1000;
+    std::cout << "vertexes: " << controller.Vertexes().size() / 3
+              << ", edges: " << controller.Facets().size() / 2 << '\n'
+              << "input events: " << events.size() << " in " << duration
+              << " s, deltas: " << stats.inputs << '\n'
+              << "frames: " << stats.frames << ", degraded: "
+              << stats.degraded_frames << '\n';
+    if (stats.frames != 0)
+      std::cout << "frame time: avg " << stats.total_ms / (double)stats.frames
+                << " ms, max " << stats.max_ms << " ms\n";
+    QApplication::quit();
+  });
+  return QApplication::exec();
+}
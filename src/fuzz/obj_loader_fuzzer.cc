@@ -0,0 +1,102 @@
+//
+// libFuzzer target for the checked OBJ loader.
+//
+// Besides crashes, it checks the properties a checked load guarantees to the
+// renderer: whole vertices, whole edges and no index past the last vertex.
+// It also edits the input and checks that re-parsing the edited text into
+// the loaded object gives the same result as parsing it from scratch.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "Model.h"
+
+namespace {
+/**
+ * Returns the input with a short range reversed or removed, which changes,
+ * joins and splits lines. The range is derived from the input itself.
+ */
+std::string Edit(std::string_view text) {
+  std::string result(text);
+  if (result.size() < 2) return result;
+  const size_t hash = std::hash<std::string_view>{}(text);
+  const size_t begin = hash % result.size();
+  const size_t length =
+      (hash >> 8) % std::min<size_t>(result.size() - begin, 64) + 1;
+  if ((hash >> 16) & 1)
+    std::reverse(result.begin() + (long)begin,
+                 result.begin() + (long)(begin + length));
+  else
+    result.erase(begin, length);
+  return result;
+}
+
+void Check(const s21::Obj& obj, const s21::ObjLimits& limits) {
+  const size_t vertexes = obj.vertexes.size() / 3;
+  if (obj.vertexes.size() % 3 != 0 || obj.facets.size() % 2 != 0)
+    __builtin_trap();
+  if (vertexes > limits.max_vertexes || obj.facets.size() > limits.max_facets)
+    __builtin_trap();
+  for (unsigned index : obj.facets)
+    if (index >= vertexes) __builtin_trap();
+  if (obj.errors.size() > limits.max_errors) __builtin_trap();
+}
+
+bool Same(const s21::Obj& a, const s21::Obj& b) {
+  const auto same_chunk = [](const s21::ObjChunk& x, const s21::ObjChunk& y) {
+    return x.hash == y.hash && x.vertexes_begin == y.vertexes_begin &&
+           x.vertexes_count == y.vertexes_count &&
+           x.facets_begin == y.facets_begin &&
+           x.facets_count == y.facets_count && x.lines == y.lines &&
+           x.max == y.max;
+  };
+  const auto same_error = [](const s21::ObjError& x, const s21::ObjError& y) {
+    return x.line == y.line && x.message == y.message;
+  };
+  return a.vertexes == b.vertexes && a.facets == b.facets && a.max == b.max &&
+         std::equal(a.chunks.begin(), a.chunks.end(), b.chunks.begin(),
+                    b.chunks.end(), same_chunk) &&
+         std::equal(a.errors.begin(), a.errors.end(), b.errors.begin(),
+                    b.errors.end(), same_error);
+}
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  static const s21::ObjLimits limits = [] {
+    s21::ObjLimits result;
+    result.max_file_size = size_t(1) << 20;
+    result.max_vertexes = size_t(1) << 16;
+    result.max_facets = size_t(1) << 18;
+    result.max_errors = 64;
+    return result;
+  }();
+  std::string_view text(reinterpret_cast<const char*>(data), size);
+  s21::Obj obj;
+  try {
+    obj = s21::ObjLoader::Parse(text, &limits);
+  } catch (const s21::ObjLoadError&) {
+    return 0;
+  }
+  Check(obj, limits);
+
+  const std::string edited = Edit(text);
+  s21::Obj expected;
+  bool is_loaded = true;
+  try {
+    expected = s21::ObjLoader::Parse(edited, &limits);
+  } catch (const s21::ObjLoadError&) {
+    is_loaded = false;
+  }
+  try {
+    s21::ObjLoader::Reparse(edited, obj, &limits);
+  } catch (const s21::ObjLoadError&) {
+    if (is_loaded) __builtin_trap();
+    return 0;
+  }
+  if (!is_loaded || !Same(obj, expected)) __builtin_trap();
+  return 0;
+}
@@ -0,0 +1,102 @@
+//
+// Headless validation, statistics and conversion of OBJ files.
+//
+
+#ifndef INC_3DVIEWER_V2_BATCHPROCESSOR_H
+#define INC_3DVIEWER_V2_BATCHPROCESSOR_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Model.h"
+
+namespace s21 {
+
+/**
+ * @brief Options of a batch run.
+ */
+struct BatchOptions {
+  std::string input;       /**< Directory with OBJ files or a single file. */
+  std::string output;      /**< Directory for converted meshes, if any. */
+  unsigned jobs = 0;       /**< Number of worker threads, 0 for automatic. */
+  bool normalize = false;  /**< Scale models to 0.9 / max before writing. */
+  ObjLimits limits;        /**< Limits of the checked load. */
+};
+
+/**
+ * @brief Result of processing a single file.
+ */
+struct BatchResult {
+  std::string path;
+  bool ok = false;            /**< File was loaded (and written). */
+  std::string error;          /**< Reason of a failure. */
+  std::vector<ObjError> issues; /**< Malformed lines found by the loader. */
+  size_t bytes = 0;
+  size_t vertexes = 0;
+  size_t edges = 0;           /**< Edges as drawn, one per facet side. */
+  size_t unique_edges = 0;    /**< Distinct undirected edges. */
+  float min[3] = {0, 0, 0};   /**< Bounding box of the source model. */
+  float max[3] = {0, 0, 0};
+  double milliseconds = 0;
+};
+
+/**
+ * @brief Headless processing of OBJ files: validation, statistics,
+ * normalization and conversion to the binary mesh format.
+ *
+ * A converted file is named after its source with ".s21m" appended, e.g.
+ * "cube.obj.s21m". Binary mesh format, native byte order:
+ * @code
+ * char[4]  magic "S21M"
+ * uint32   version (1)
+ * uint64   number of coordinates
+ * uint64   number of facet indices
+ * float    max, as in Obj::max, of the written coordinates
+ * float[]  coordinates
+ * uint32[] facet indices, pairs of vertex numbers forming edges
+ * @endcode
+ */
+class BatchProcessor {
+ public:
+  explicit BatchProcessor(BatchOptions options);
+
+  /**
+   * @brief Processes all files. Each worker keeps at most one model in
+   * memory, so the peak memory use is bounded by the number of jobs.
+   * @param report Called from worker threads, serialized, for every
+   * finished file.
+   * @return Results in the order of the input files.
+   */
+  std::vector<BatchResult> Run(
+      const std::function<void(const BatchResult&)>& report);
+
+  /**
+   * @brief Processes a single file.
+   * @param path The path to the OBJ file.
+   * @return Result of processing.
+   */
+  [[nodiscard]] BatchResult Process(const std::string& path) const;
+
+  /**
+   * @brief Lists OBJ files of the input, sorted by name.
+   * @return Paths of the files.
+   */
+  [[nodiscard]] std::vector<std::string> Files() const;
+
+  /**
+   * @brief Writes obj in the binary mesh format.
+   * @param path The path of the output file.
+   * @param obj The object to write.
+   */
+  static void WriteMesh(const std::string& path, const Obj& obj);
+
+ private:
+  BatchOptions options_;
+
+  static void CollectStatistics(const Obj& obj, BatchResult& result);
+};
+
+}  // namespace s21
+
+#endif  // INC_3DVIEWER_V2_BATCHPROCESSOR_H
@@ -15,10 +15,12 @@ class Controller {
   explicit Controller(Model& model);
 
   void LoadOBJ(const std::string& path);
+  ObjDelta ReloadOBJ(const std::string& path);
   void Scale(float factor);
 
   [[nodiscard]] const vertexes_type& Vertexes() const;
   [[nodiscard]] const facets_type& Facets() const;
+  [[nodiscard]] const std::vector<ObjError>& Errors() const;
  private:
   Model& model_;
 };
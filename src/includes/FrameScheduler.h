@@ -0,0 +1,119 @@
+//
+// Frame pacing and level-of-detail selection for the OpenGL widget.
+//
+
+#ifndef INC_3DVIEWER_V2_FRAMESCHEDULER_H
+#define INC_3DVIEWER_V2_FRAMESCHEDULER_H
+
+#include <cstddef>
+
+namespace s21 {
+
+/**
+ * @brief Interaction accumulated since the previous frame.
+ */
+struct FrameDelta {
+  float x_angle = 0; /**< Rotation around the x axis, degrees. */
+  float y_angle = 0; /**< Rotation around the y axis, degrees. */
+  float pan_x = 0;
+  float pan_y = 0;
+};
+
+/**
+ * @brief Counters of rendered frames.
+ */
+struct FrameStats {
+  size_t inputs = 0;          /**< Input deltas received. */
+  size_t frames = 0;          /**< Frames with a measured frame time. */
+  size_t degraded_frames = 0; /**< Frames rendered with reduced detail. */
+  double total_ms = 0;
+  double max_ms = 0;
+};
+
+/**
+ * @brief Coalesces input deltas between frames and chooses the level of
+ * detail from the measured frame time.
+ *
+ * Input only accumulates into a pending delta, which the next frame takes as
+ * a whole, so the number of frames does not depend on the input rate. While
+ * the user interacts and frames are slower than the budget, the detail
+ * stride doubles. It halves again when rendering takes well under the
+ * budget, and returns to full detail when the interaction ends or pauses.
+ */
+class FrameScheduler {
+ public:
+  /**
+   * @param budget_ms Frame time above which detail is reduced.
+   * @param max_stride Coarsest level of detail, a power of two.
+   */
+  explicit FrameScheduler(double budget_ms = 20,
+                          unsigned max_stride = 16) noexcept;
+
+  void AddRotation(float x_angle, float y_angle) noexcept;
+  void AddPan(float x, float y) noexcept;
+
+  /**
+   * @brief Requests a frame without input, e.g. after the data changed.
+   */
+  void Invalidate() noexcept;
+
+  /**
+   * @brief Returns whether a frame is needed.
+   */
+  [[nodiscard]] bool IsDirty() const noexcept;
+
+  /**
+   * @brief Returns the pending delta and clears it.
+   */
+  FrameDelta TakeDelta() noexcept;
+
+  void BeginInteraction() noexcept;
+
+  /**
+   * @brief Ends the interaction and restores full detail.
+   */
+  void EndInteraction() noexcept;
+
+  /**
+   * @brief Restores full detail, e.g. when the input pauses during an
+   * interaction. Requests a frame if the detail changes.
+   */
+  void RestoreDetail() noexcept;
+
+  /**
+   * @brief Reports the time of a frame rendered with the current stride.
+   * Reduces detail when it is over the budget.
+   * @param milliseconds Time between the frame and the previous one.
+   */
+  void FrameRendered(double milliseconds) noexcept;
+
+  /**
+   * @brief Reports the time spent rendering a frame. Frame intervals are
+   * bound to the display refresh, so detail is restored by this time.
+   * @param milliseconds Rendering time of the frame.
+   * @param stride The stride the frame was rendered with.
+   */
+  void RenderMeasured(double milliseconds, unsigned stride) noexcept;
+
+  /**
+   * @brief Returns the detail stride, 1 for full detail. Only every
+   * stride-th point and edge is drawn.
+   */
+  [[nodiscard]] unsigned Stride() const noexcept;
+
+  [[nodiscard]] const FrameStats& Stats() const noexcept;
+  void ResetStats() noexcept;
+
+ private:
+  double budget_ms_;
+  unsigned max_stride_;
+  unsigned stride_ = 1;
+  bool is_dirty_ = false;
+  bool is_interacting_ = false;
+  FrameDelta delta_;
+  FrameStats stats_;
+};
+
+}  // namespace s21
+
+#endif  // INC_3DVIEWER_V2_FRAMESCHEDULER_H
@@ -0,0 +1,45 @@
+//
+// Recording of mouse input for replay benchmarks.
+//
+
+#ifndef INC_3DVIEWER_V2_INPUTTRACE_H
+#define INC_3DVIEWER_V2_INPUTTRACE_H
+
+#include <QElapsedTimer>
+#include <QMouseEvent>
+#include <QString>
+#include <vector>
+
+/**
+ * @brief Recorded mouse event.
+ */
+struct InputEvent {
+  qint64 time; /**< Milliseconds since the start of the recording. */
+  QEvent::Type type;
+  Qt::MouseButton button;
+  Qt::MouseButtons buttons;
+  QPointF position;
+};
+
+/**
+ * @brief Records mouse events of a widget and reads them back for replay.
+ *
+ * A trace is a text file with one event per line:
+ * @code
+ * <time ms> <QEvent::Type> <button> <buttons> <x> <y>
+ * @endcode
+ */
+class InputTrace {
+ public:
+  InputTrace();
+
+  void Record(const QMouseEvent* event);
+  bool Save(const QString& path) const;
+  static std::vector<InputEvent> Load(const QString& path);
+
+ private:
+  QElapsedTimer timer_;
+  std::vector<InputEvent> events_;
+};
+
+#endif  // INC_3DVIEWER_V2_INPUTTRACE_H
@@ -5,7 +5,9 @@
 #ifndef INC_3DVIEWER_V2_MAINVIEW_H
 #define INC_3DVIEWER_V2_MAINVIEW_H
 
+#include <QFileSystemWatcher>
 #include <QMainWindow>
+#include <QTimer>
 
 #include "Controller.h"
 #include "Model.h"
@@ -23,15 +25,27 @@ class MainView : public QMainWindow, public Observer {
   void on_open_file_clicked();
   void on_plusButton_clicked();
   void on_minusButton_clicked();
+  void on_watchCheckBox_toggled(bool checked);
+  void OnFileChanged();
+  void ReloadFile();
 
  private:
   Ui::MainView* ui_;
   Controller& controller_;
   Model& model_;
+  QString path_;
+  QFileSystemWatcher watcher_;
+  QTimer reload_timer_;
+  bool is_facets_stale_ = false; /**< Set while a new model is loaded. */
 
   void Update() override;
 
   void OpenFile(const QString& path);
+  void ShowInfo();
+  QString ErrorsText() const;
+  void ShowErrors();
+  void ShowReloadStatus();
+  void Watch();
 };
 }  // namespace s21
 
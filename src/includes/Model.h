@@ -5,7 +5,9 @@
 #ifndef CPP4_3DVIEWER_V2_0_2_MODEL_H
 #define CPP4_3DVIEWER_V2_0_2_MODEL_H
 
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace s21 {
@@ -20,6 +22,60 @@ using vertexes_type = std::vector<float>;
  */
 using facets_type = std::vector<unsigned>;
 
+/**
+ * @brief Structure describing a contiguous run of lines of the OBJ file and
+ * the ranges of Obj data produced by it.
+ */
+struct ObjChunk {
+  size_t hash;           /**< Hash of the raw chunk text. */
+  size_t vertexes_begin; /**< Offset of the chunk data in Obj::vertexes. */
+  size_t vertexes_count; /**< Number of coordinates parsed from the chunk. */
+  size_t facets_begin;   /**< Offset of the chunk data in Obj::facets. */
+  size_t facets_count;   /**< Number of indices parsed from the chunk. */
+  size_t lines;          /**< Number of lines in the chunk. */
+  float max;             /**< Coordinate with the largest magnitude. */
+};
+
+/**
+ * @brief Structure describing a malformed line found by a checked load.
+ */
+struct ObjError {
+  size_t line;         /**< 1-based line number. */
+  std::string message; /**< Description of the problem. */
+};
+
+/**
+ * @brief Limits enforced by a checked load.
+ */
+struct ObjLimits {
+  size_t max_file_size = size_t(1) << 30; /**< File size in bytes. */
+  size_t max_vertexes = size_t(1) << 26;  /**< Number of vertices. */
+  size_t max_facets = size_t(1) << 28;    /**< Size of Obj::facets. */
+  size_t max_facet_vertexes = 1024;       /**< Vertices of a single facet. */
+  size_t max_errors = 1000;               /**< Skipped lines. */
+};
+
+/**
+ * @brief Exception thrown when a checked load exceeds one of the limits.
+ */
+class ObjLoadError : public std::runtime_error {
+ public:
+  ObjLoadError(size_t line, const std::string& message);
+
+  /**
+   * @brief Returns the 1-based line number, 0 for the whole file.
+   */
+  [[nodiscard]] size_t Line() const noexcept;
+
+ private:
+  size_t line_;
+};
+
+/**
+ * @brief Type alias for storing the chunk layout of a loaded file.
+ */
+using chunks_type = std::vector<ObjChunk>;
+
 /**
  * @brief Structure representing an object in 3D space with its vertices and
  * facets.
@@ -28,6 +84,19 @@ struct Obj {
   vertexes_type vertexes; /**< Vector of vertex coordinates. */
   facets_type facets;     /**< Vector of facet indices. */
   float max;
+  chunks_type chunks; /**< Chunk layout of the source file. */
+  std::vector<ObjError> errors; /**< Malformed lines found by a checked load. */
+};
+
+/**
+ * @brief Structure describing which ranges of Obj were changed by a reload.
+ */
+struct ObjDelta {
+  bool full = true; /**< The whole object was replaced. */
+  size_t vertexes_begin = 0;
+  size_t vertexes_count = 0;
+  size_t facets_begin = 0;
+  size_t facets_count = 0;
 };
 
 /**
@@ -82,27 +151,119 @@ class ObjLoader {
   /**
    * @brief Loads an OBJ file and returns an Obj instance representing the
    * loaded object.
+   *
+   * Without limits malformed lines and values are skipped silently and facet
+   * indices are not checked. With limits every malformed line is reported in
+   * Obj::errors, malformed vertices are replaced by the origin so that the
+   * vertices after them keep their numbers, facets referring to missing
+   * vertices are skipped, and ObjLoadError is thrown when a limit is
+   * exceeded.
    * @param path The path to the OBJ file.
+   * @param limits Limits of a checked load, nullptr for an unchecked one.
    * @return Obj instance representing the loaded object.
    */
-  static Obj Load(const std::string& path);
+  static Obj Load(const std::string& path,
+                  const ObjLimits* limits = nullptr);
+
+  /**
+   * @brief Parses OBJ data held in memory, see Load().
+   * @param data The file contents.
+   * @param limits Limits of a checked load, nullptr for an unchecked one.
+   * @return Obj instance representing the parsed object.
+   */
+  static Obj Parse(std::string_view data, const ObjLimits* limits = nullptr);
+
+  /**
+   * @brief Re-reads an OBJ file previously loaded into obj and re-parses only
+   * the chunks whose contents changed. Falls back to a full load when the
+   * number of vertices or facet indices changes, or when the largest
+   * coordinate changes.
+   * @param path The path to the OBJ file.
+   * @param obj The object to update in place.
+   * @param limits Limits of a checked load, nullptr for an unchecked one.
+   * @return Ranges of obj that were replaced.
+   */
+  static ObjDelta Reload(const std::string& path, Obj& obj,
+                         const ObjLimits* limits = nullptr);
+
+  /**
+   * @brief Re-parses OBJ data held in memory into obj, see Reload().
+   * @param data The new file contents.
+   * @param obj The object previously parsed from the old contents.
+   * @param limits Limits of a checked load, nullptr for an unchecked one.
+   * @return Ranges of obj that were replaced.
+   */
+  static ObjDelta Reparse(std::string_view data, Obj& obj,
+                          const ObjLimits* limits = nullptr);
 
  private:
   ObjLoader(){}; /**< Private constructor to enforce singleton pattern. */
 
   /**
-   * @brief Splits a string into substrings based on whitespace.
-   * @param s The string to split.
-   * @return Vector of substrings.
+   * @brief State of parsing a sequence of lines.
+   */
+  struct ParseState {
+    const ObjLimits* limits; /**< nullptr for an unchecked load. */
+    size_t line;             /**< Number of the current line. */
+    size_t vertexes_before;  /**< Coordinates preceding the parsed data. */
+    float max;               /**< Coordinate with the largest magnitude. */
+    facets_type numbers;     /**< Vertex numbers of the current facet. */
+  };
+
+  /**
+   * @brief Reads the whole file into memory.
+   * @param path The path to the file.
+   * @param limits Limits of a checked load, nullptr for an unchecked one.
+   * @return File contents.
+   */
+  static std::string ReadFile(const std::string& path,
+                              const ObjLimits* limits);
+
+  /**
+   * @brief Splits file contents into chunks of whole lines. Chunk boundaries
+   * depend on line contents only, so an edit does not move the boundaries of
+   * the chunks around it.
+   * @param data The file contents.
+   * @return Views of the chunks.
+   */
+  static std::vector<std::string_view> SplitChunks(
+      std::string_view data) noexcept;
+
+  /**
+   * @brief Parses a chunk and appends its data to obj.
+   * @param chunk The chunk text.
+   * @param obj The object to append to.
+   * @param state The parsing state, advanced past the chunk.
+   * @return Description of the parsed chunk.
+   */
+  static ObjChunk ParseChunk(std::string_view chunk, Obj& obj,
+                             ParseState& state);
+
+  /**
+   * @brief Parses a single line and appends its data to obj.
+   * @param line The line to parse.
+   * @param obj The object to append to.
+   * @param state The parsing state.
+   */
+  static void ParseLine(std::string_view line, Obj& obj, ParseState& state);
+
+  /**
+   * @brief Parses all chunks into a new Obj instance.
+   * @param chunks Views of the chunks.
+   * @param limits Limits of a checked load, nullptr for an unchecked one.
+   * @return The parsed object.
    */
-  static std::vector<std::string> Split(const std::string& s) noexcept;
+  static Obj ParseAll(const std::vector<std::string_view>& chunks,
+                      const ObjLimits* limits);
 
   /**
-   * @brief Extracts the first number from a string.
-   * @param s The string containing the number.
-   * @return The extracted number.
+   * @brief Records a malformed line in a checked load.
+   * @param obj The object being parsed.
+   * @param state The parsing state.
+   * @param message Description of the problem.
    */
-  static unsigned ExtractNumber(const std::string& s);
+  static void AddError(Obj& obj, const ParseState& state,
+                       std::string message);
 };
 
 /**
@@ -127,11 +288,20 @@ class Observable {
 class Model: public Observable {
  public:
   /**
-   * @brief Loads an OBJ file and populates the model with its data.
+   * @brief Loads an OBJ file and populates the model with its data. The file
+   * is checked against the default ObjLimits.
    * @param path The path to the OBJ file.
    */
   void LoadObj(const std::string& path);
 
+  /**
+   * @brief Reloads the OBJ file, patching only the changed ranges of the
+   * model when possible.
+   * @param path The path to the OBJ file.
+   * @return Ranges of the model data that were replaced.
+   */
+  ObjDelta ReloadObj(const std::string& path);
+
   /**
    * @brief Scales the model by the specified factor.
    * @param factor The scaling factor.
@@ -166,10 +336,19 @@ class Model: public Observable {
 
   [[nodiscard]] float Max() const noexcept;
 
+  /**
+   * @brief Returns the malformed lines found while loading the model.
+   * @return Const reference to the errors.
+   */
+  [[nodiscard]] const std::vector<ObjError>& Errors() const noexcept;
+
   [[nodiscard]] bool Empty() const noexcept;
 
  private:
   Obj obj_; /**< The loaded OBJ data representing the model. */
+  ObjLimits limits_; /**< Limits applied to loaded files. */
+  float scale_ = 1; /**< Scale applied to the model since loading. */
+  bool transformed_ = false; /**< Model was rotated or moved since loading. */
 };
 
 }  // namespace s21
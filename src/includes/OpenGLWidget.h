@@ -6,12 +6,18 @@
 #define INC_3DVIEWER_V2_OPENGLWIDGET_H
 
 #include <QOpenGLFunctions>
+#include <QOpenGLTimerQuery>
 #include <QOpenGLWidget>
 #include <QMouseEvent>
 #include <QtCore>
 #include <QtOpenGL>
+#include <memory>
 #include <vector>
 
+#include "FrameScheduler.h"
+#include "InputTrace.h"
+#include "RenderPipeline.h"
+
 class OpenGLWidget : public QOpenGLWidget, protected QOpenGLExtraFunctions {
   Q_OBJECT
 
@@ -23,7 +29,11 @@ class OpenGLWidget : public QOpenGLWidget, protected QOpenGLExtraFunctions {
   void SetVertexes(const std::vector<GLfloat>* vertexes);
   void SetFacets(const std::vector<unsigned>* facets);
   void LoadDataToBuffers();
+  void LoadVertexesToBuffer();
+  void LoadDataToBuffers(size_t vertexes_begin, size_t vertexes_count,
+                         size_t facets_begin, size_t facets_count);
   void InitModelMatrix();
+  [[nodiscard]] const s21::FrameScheduler& Scheduler() const;
 
  protected:
   void initializeGL() override;
@@ -33,9 +43,21 @@ class OpenGLWidget : public QOpenGLWidget, protected QOpenGLExtraFunctions {
   void mouseMoveEvent(QMouseEvent* mouse) override;
   void mouseReleaseEvent(QMouseEvent* mouse) override;
 
+ private slots:
+  void OnFrameSwapped();
+  void OnIdle();
+
  private:
-  GLuint shader_program_;
+  /** Reduced levels of detail, with strides 2, 4, ... 2^kLodLevels. */
+  static constexpr int kLodLevels = 4;
+
+  RenderPipeline pipeline_;
   GLuint VAO, VBO, EBO;
+  GLuint lod_lines_VAO_, lod_EBO_;
+  GLuint lod_points_VAOs_[kLodLevels];
+  size_t lod_facets_begin_[kLodLevels] = {};
+  size_t lod_facets_count_[kLodLevels] = {};
+  bool is_lod_stale_ = true;
   bool is_data_load_ = false;
   bool is_rotating_ = false;
   bool is_panning_ = false;
@@ -45,14 +67,24 @@ class OpenGLWidget : public QOpenGLWidget, protected QOpenGLExtraFunctions {
   QMatrix4x4 projection_matrix_;
   const std::vector<GLfloat>* vertexes_ = nullptr;
   const std::vector<unsigned>* facets_ = nullptr;
+  bool is_stats_enabled_ = false;
+  qint64 frames_ = 0;
+  qint64 frames_nsecs_ = 0;
+  s21::FrameScheduler scheduler_;
+  QElapsedTimer frame_timer_;
+  bool is_frame_continuous_ = false;
+  QOpenGLTimerQuery render_query_;
+  bool is_render_query_pending_ = false;
+  unsigned render_query_stride_ = 1;
+  QTimer idle_timer_;
+  std::unique_ptr<InputTrace> trace_;
 
-  static std::optional<std::string> GetShaderSource(
-      const std::string& filename);
   void InitBuffers();
-  void InitShaderProgram();
+  void LoadLodBuffers();
+  void LoadLodBuffers(size_t facets_begin, size_t facets_count);
   void RotateCoordinateSystem(float angle, const QVector3D& axis);
-
-
+  void ApplyDelta(const s21::FrameDelta& delta);
+  void TakeRenderTime();
 };
 
 #endif  // INC_3DVIEWER_V2_OPENGLWIDGET_H
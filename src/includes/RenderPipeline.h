@@ -0,0 +1,59 @@
+//
+// Shader program and uniform state of the OpenGL widget.
+//
+
+#ifndef INC_3DVIEWER_V2_RENDERPIPELINE_H
+#define INC_3DVIEWER_V2_RENDERPIPELINE_H
+
+#include <QMatrix4x4>
+#include <QOpenGLExtraFunctions>
+
+/**
+ * @brief Shader program with the transformation matrices in a uniform
+ * buffer.
+ *
+ * Shader sources are embedded into the binary at build time. Lines and
+ * points are drawn with the same program, so the render loop binds it once
+ * and never looks up uniforms.
+ */
+class RenderPipeline {
+ public:
+  /**
+   * @brief Compiles the program and creates the uniform buffer. Requires a
+   * current OpenGL context.
+   * @param gl Functions of the context.
+   * @return Whether the program was linked.
+   */
+  bool Init(QOpenGLExtraFunctions* gl);
+
+  /**
+   * @brief Releases the OpenGL objects. Requires a current OpenGL context.
+   */
+  void Destroy();
+
+  /**
+   * @brief Uploads the matrices that differ from the previous call.
+   */
+  void SetMatrices(const QMatrix4x4& model, const QMatrix4x4& view,
+                   const QMatrix4x4& projection);
+
+  /**
+   * @brief Makes the program current, unless it already is.
+   */
+  void Use();
+
+ private:
+  static constexpr GLuint kMatricesBinding = 0;
+
+  QOpenGLExtraFunctions* gl_ = nullptr;
+  GLuint program_ = 0;
+  bool is_current_ = false;
+  GLuint ubo_ = 0;
+  QMatrix4x4 matrices_[3];
+  bool is_uploaded_ = false;
+
+  GLuint CompileShader(GLenum type, const char* source);
+  GLuint LinkProgram();
+};
+
+#endif  // INC_3DVIEWER_V2_RENDERPIPELINE_H
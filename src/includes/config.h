@@ -1,10 +0,0 @@
-//
-// Created by Глеб Писарев on 26.02.2024.
-//
-
-#ifndef INC_3DVIEWER_V2_CONFIG_H
-#define INC_3DVIEWER_V2_CONFIG_H
-
-#define SHADER_PATH "ВАШ_ПУТЬ/3DViewer_v2/src/sources/shaders/"
-
-#endif  // INC_3DVIEWER_V2_CONFIG_H
@@ -0,0 +1,131 @@
+//
+// Headless validation, statistics and conversion of OBJ files.
+//
+
+#include "BatchProcessor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+s21::BatchProcessor::BatchProcessor(s21::BatchOptions options)
+    : options_(std::move(options)) {}
+
+std::vector<s21::BatchResult> s21::BatchProcessor::Run(
+    const std::function<void(const BatchResult&)>& report) {
+  const auto files = Files();
+  std::vector<BatchResult> results(files.size());
+  unsigned jobs = options_.jobs;
+  if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+  jobs = (unsigned)std::min<size_t>(jobs, files.size());
+
+  std::atomic<size_t> next = 0;
+  std::mutex report_mutex;
+  std::vector<std::thread> workers;
+  for (unsigned i = 0; i < jobs; ++i) {
+    workers.emplace_back([&]() {
+      for (size_t index = next++; index < files.size(); index = next++) {
+        results[index] = Process(files[index]);
+        std::lock_guard<std::mutex> lock(report_mutex);
+        if (report) report(results[index]);
+      }
+    });
+  }
+  for (auto& worker : workers) worker.join();
+  return results;
+}
+
+s21::BatchResult s21::BatchProcessor::Process(const std::string& path) const {
+  BatchResult result;
+  result.path = path;
+  const auto begin = std::chrono::steady_clock::now();
+  try {
+    result.bytes = std::filesystem::file_size(path);
+    Obj obj = ObjLoader::GetInstance().Load(path, &options_.limits);
+    result.issues = std::move(obj.errors);
+    CollectStatistics(obj, result);
+    if (options_.normalize && obj.max != 0) {
+      const float factor = 0.9f / obj.max;
+      Affine::GetInstance().Scale(obj.vertexes, factor);
+      obj.max = obj.max * factor;
+    }
+    if (!options_.output.empty()) {
+      // The source extension is kept, since files are matched by extension
+      // case-insensitively and "a.obj" and "a.OBJ" may both exist.
+      auto output = std::filesystem::path(options_.output) /
+                    std::filesystem::path(path).filename();
+      WriteMesh(output.string() + ".s21m", obj);
+    }
+    result.ok = true;
+  } catch (const std::exception& e) {
+    result.error = e.what();
+  }
+  result.milliseconds = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - begin)
+                            .count();
+  return result;
+}
+
+std::vector<std::string> s21::BatchProcessor::Files() const {
+  namespace fs = std::filesystem;
+  std::vector<std::string> files;
+  if (!fs::is_directory(options_.input)) {
+    files.push_back(options_.input);
+    return files;
+  }
+  for (const auto& entry : fs::directory_iterator(options_.input)) {
+    auto extension = entry.path().extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    if (entry.is_regular_file() && extension == ".obj")
+      files.push_back(entry.path().string());
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+void s21::BatchProcessor::WriteMesh(const std::string& path, const Obj& obj) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) throw std::runtime_error("Opening error: " + path);
+  const uint32_t version = 1;
+  const uint64_t vertexes = obj.vertexes.size();
+  const uint64_t facets = obj.facets.size();
+  file.write("S21M", 4);
+  file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  file.write(reinterpret_cast<const char*>(&vertexes), sizeof(vertexes));
+  file.write(reinterpret_cast<const char*>(&facets), sizeof(facets));
+  file.write(reinterpret_cast<const char*>(&obj.max), sizeof(obj.max));
+  file.write(reinterpret_cast<const char*>(obj.vertexes.data()),
+             (std::streamsize)(sizeof(float) * vertexes));
+  file.write(reinterpret_cast<const char*>(obj.facets.data()),
+             (std::streamsize)(sizeof(unsigned) * facets));
+  if (!file) throw std::runtime_error("Writing error: " + path);
+}
+
+void s21::BatchProcessor::CollectStatistics(const Obj& obj,
+                                            BatchResult& result) {
+  result.vertexes = obj.vertexes.size() / 3;
+  result.edges = obj.facets.size() / 2;
+  std::unordered_set<uint64_t> edges;
+  edges.reserve(result.edges);
+  for (size_t i = 0; i + 1 < obj.facets.size(); i += 2) {
+    uint64_t a = std::min(obj.facets[i], obj.facets[i + 1]);
+    uint64_t b = std::max(obj.facets[i], obj.facets[i + 1]);
+    edges.insert(a << 32 | b);
+  }
+  result.unique_edges = edges.size();
+  for (size_t i = 0; i + 2 < obj.vertexes.size(); i += 3) {
+    for (size_t j = 0; j < 3; ++j) {
+      if (i == 0 || obj.vertexes[i + j] < result.min[j])
+        result.min[j] = obj.vertexes[i + j];
+      if (i == 0 || obj.vertexes[i + j] > result.max[j])
+        result.max[j] = obj.vertexes[i + j];
+    }
+  }
+}
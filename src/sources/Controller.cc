@@ -10,12 +10,25 @@ void s21::Controller::LoadOBJ(const std::string& path) {
   model_.LoadObj(path);
   if (model_.Max() != 0) Scale(0.9f / model_.Max());
 }
+s21::ObjDelta s21::Controller::ReloadOBJ(const std::string& path) {
+  ObjDelta delta = model_.ReloadObj(path);
+  if (!delta.full) return delta;
+  // Observers upload the replaced model, through Scale when it is scaled.
+  if (model_.Max() != 0)
+    Scale(0.9f / model_.Max());
+  else
+    model_.NotifyObservers();
+  return delta;
+}
 const s21::vertexes_type& s21::Controller::Vertexes() const {
   return model_.Vertexes();
 }
 const s21::facets_type& s21::Controller::Facets() const {
   return model_.Facets();
 }
+const std::vector<s21::ObjError>& s21::Controller::Errors() const {
+  return model_.Errors();
+}
 void s21::Controller::Scale(float factor) {
   model_.Scale(factor);
 }
@@ -0,0 +1,75 @@
+//
+// Frame pacing and level-of-detail selection for the OpenGL widget.
+//
+
+#include "FrameScheduler.h"
+
+#include <algorithm>
+
+namespace {
+/**
+ * Halving the stride roughly doubles the frame time, so detail is raised
+ * back during an interaction only when it still fits with some margin.
+ */
+constexpr double kRestoreRatio = 0.4;
+}  // namespace
+
+s21::FrameScheduler::FrameScheduler(double budget_ms,
+                                    unsigned max_stride) noexcept
+    : budget_ms_(budget_ms), max_stride_(std::max(1u, max_stride)) {}
+
+void s21::FrameScheduler::AddRotation(float x_angle, float y_angle) noexcept {
+  delta_.x_angle += x_angle;
+  delta_.y_angle += y_angle;
+  ++stats_.inputs;
+  is_dirty_ = true;
+}
+void s21::FrameScheduler::AddPan(float x, float y) noexcept {
+  delta_.pan_x += x;
+  delta_.pan_y += y;
+  ++stats_.inputs;
+  is_dirty_ = true;
+}
+void s21::FrameScheduler::Invalidate() noexcept { is_dirty_ = true; }
+bool s21::FrameScheduler::IsDirty() const noexcept { return is_dirty_; }
+s21::FrameDelta s21::FrameScheduler::TakeDelta() noexcept {
+  FrameDelta delta = delta_;
+  delta_ = FrameDelta();
+  is_dirty_ = false;
+  return delta;
+}
+
+void s21::FrameScheduler::BeginInteraction() noexcept {
+  is_interacting_ = true;
+}
+void s21::FrameScheduler::EndInteraction() noexcept {
+  is_interacting_ = false;
+  RestoreDetail();
+}
+void s21::FrameScheduler::RestoreDetail() noexcept {
+  if (stride_ != 1) {
+    stride_ = 1;
+    is_dirty_ = true;
+  }
+}
+
+void s21::FrameScheduler::FrameRendered(double milliseconds) noexcept {
+  ++stats_.frames;
+  stats_.total_ms += milliseconds;
+  stats_.max_ms = std::max(stats_.max_ms, milliseconds);
+  if (stride_ != 1) ++stats_.degraded_frames;
+  if (is_interacting_ && milliseconds > budget_ms_ && stride_ < max_stride_)
+    stride_ = std::min(stride_ * 2, max_stride_);
+}
+void s21::FrameScheduler::RenderMeasured(double milliseconds,
+                                         unsigned stride) noexcept {
+  if (is_interacting_ && stride == stride_ && stride_ > 1 &&
+      milliseconds < budget_ms_ * kRestoreRatio)
+    stride_ /= 2;
+}
+
+unsigned s21::FrameScheduler::Stride() const noexcept { return stride_; }
+const s21::FrameStats& s21::FrameScheduler::Stats() const noexcept {
+  return stats_;
+}
+void s21::FrameScheduler::ResetStats() noexcept { stats_ = FrameStats(); }
@@ -0,0 +1,45 @@
+//
+// Recording of mouse input for replay benchmarks.
+//
+
+#include "InputTrace.h"
+
+#include <QFile>
+#include <QTextStream>
+
+InputTrace::InputTrace() { timer_.start(); }
+
+void InputTrace::Record(const QMouseEvent *event) {
+  events_.push_back({timer_.elapsed(), event->type(), event->button(),
+                     event->buttons(), event->position()});
+}
+
+bool InputTrace::Save(const QString &path) const {
+  QFile file(path);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+  QTextStream out(&file);
+  for (const auto &event : events_) {
+    out << event.time << ' ' << (int)event.type << ' ' << (int)event.button
+        << ' ' << (int)event.buttons << ' ' << event.position.x() << ' '
+        << event.position.y() << '\n';
+  }
+  return true;
+}
+
+std::vector<InputEvent> InputTrace::Load(const QString &path) {
+  std::vector<InputEvent> events;
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) return events;
+  QTextStream in(&file);
+  while (!in.atEnd()) {
+    qint64 time;
+    int type, button, buttons;
+    double x, y;
+    in >> time >> type >> button >> buttons >> x >> y;
+    if (in.status() != QTextStream::Ok) break;
+    events.push_back({time, (QEvent::Type)type, (Qt::MouseButton)button,
+                      Qt::MouseButtons(QFlag(buttons)), QPointF(x, y)});
+    in.skipWhiteSpace();
+  }
+  return events;
+}
@@ -5,17 +5,38 @@
 #include "MainView.h"
 
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+#include <QStatusBar>
+
+namespace {
+/** Number of errors listed in the warning after loading. */
+constexpr size_t kShownErrors = 5;
+}  // namespace
 
 s21::MainView::MainView(s21::Controller& controller, s21::Model& model)
     : controller_(controller), model_(model), ui_(new Ui::MainView) {
   model_.AddObserver(this);
   ui_->setupUi(this);
+  // Writers usually touch the file several times per save, so reloads are
+  // delayed until the file has been quiet for a moment.
+  reload_timer_.setSingleShot(true);
+  reload_timer_.setInterval(100);
+  connect(&reload_timer_, &QTimer::timeout, this, &MainView::ReloadFile);
+  connect(&watcher_, &QFileSystemWatcher::fileChanged, this,
+          &MainView::OnFileChanged);
+  connect(&watcher_, &QFileSystemWatcher::directoryChanged, this,
+          &MainView::OnFileChanged);
 }
 
 s21::MainView::~MainView() { delete ui_; }
 
 void s21::MainView::Update() {
-  ui_->openGL->LoadDataToBuffers();
+  // Scaling only moves vertices, the facets on the GPU stay valid.
+  if (is_facets_stale_)
+    ui_->openGL->LoadDataToBuffers();
+  else
+    ui_->openGL->LoadVertexesToBuffer();
   ui_->openGL->update();
 }
 
@@ -25,16 +46,59 @@ void s21::MainView::on_open_file_clicked() {
   if (!path.isEmpty()) OpenFile(path);
 }
 void s21::MainView::OpenFile(const QString& path) {
-  controller_.LoadOBJ(path.toStdString());
+  is_facets_stale_ = true;
+  try {
+    controller_.LoadOBJ(path.toStdString());
+  } catch (const std::exception& e) {
+    is_facets_stale_ = false;
+    QMessageBox::warning(this, "Ошибка", e.what());
+    return;
+  }
+  path_ = path;
+  Watch();
+  ShowInfo();
+  ui_->openGL->SetVertexes(&controller_.Vertexes());
+  ui_->openGL->SetFacets(&controller_.Facets());
+  ui_->openGL->InitModelMatrix();
+  Update();
+  is_facets_stale_ = false;
+  ShowErrors();
+}
+void s21::MainView::ShowInfo() {
   ui_->vertexesLabel->setText(
       "Вершины: " +
       QVariant((int)controller_.Vertexes().size() / 3).toString());
   ui_->edgesLabel->setText(
       "Вершины: " + QVariant((int)controller_.Facets().size() / 3).toString());
-  ui_->openGL->SetVertexes(&controller_.Vertexes());
-  ui_->openGL->SetFacets(&controller_.Facets());
-  ui_->openGL->InitModelMatrix();
-  Update();
+}
+QString s21::MainView::ErrorsText() const {
+  const auto& errors = controller_.Errors();
+  QString text = "Строк с ошибками: " + QString::number(errors.size());
+  for (size_t i = 0; i < errors.size() && i < kShownErrors; ++i) {
+    text += "\nСтрока " + QString::number(errors[i].line) + ": " +
+            QString::fromStdString(errors[i].message);
+  }
+  return text;
+}
+void s21::MainView::ShowErrors() {
+  if (controller_.Errors().empty()) return;
+  QMessageBox::warning(this, "Ошибки в файле", ErrorsText());
+}
+void s21::MainView::ShowReloadStatus() {
+  // Reloads are triggered by the watcher, so they are reported without
+  // dialogs that a frequently rewritten file would stack up.
+  const auto& errors = controller_.Errors();
+  if (errors.empty()) {
+    statusBar()->showMessage("Файл перезагружен");
+    statusBar()->setToolTip(QString());
+    return;
+  }
+  statusBar()->showMessage(
+      "Файл перезагружен, строк с ошибками: " +
+      QString::number(errors.size()) + ". Строка " +
+      QString::number(errors.front().line) + ": " +
+      QString::fromStdString(errors.front().message));
+  statusBar()->setToolTip(ErrorsText());
 }
 void s21::MainView::on_plusButton_clicked() {
   controller_.Scale(1.15);
@@ -42,3 +106,48 @@ void s21::MainView::on_plusButton_clicked() {
 void s21::MainView::on_minusButton_clicked() {
   controller_.Scale(0.9);
 }
+void s21::MainView::on_watchCheckBox_toggled(bool checked) {
+  if (!checked) reload_timer_.stop();
+  Watch();
+}
+void s21::MainView::Watch() {
+  if (!watcher_.files().isEmpty()) watcher_.removePaths(watcher_.files());
+  if (!watcher_.directories().isEmpty())
+    watcher_.removePaths(watcher_.directories());
+  if (!ui_->watchCheckBox->isChecked() || path_.isEmpty()) return;
+  // Writers that delete and recreate the file drop it from the watcher, so
+  // its directory is watched until the file is back.
+  if (QFileInfo::exists(path_))
+    watcher_.addPath(path_);
+  else
+    watcher_.addPath(QFileInfo(path_).absolutePath());
+}
+void s21::MainView::OnFileChanged() {
+  if (!watcher_.files().contains(path_) && QFileInfo::exists(path_)) Watch();
+  reload_timer_.start();
+}
+void s21::MainView::ReloadFile() {
+  if (path_.isEmpty()) return;
+  if (!watcher_.files().contains(path_)) Watch();
+  if (!QFileInfo::exists(path_)) return;
+  ObjDelta delta;
+  // A full reload uploads the model through Update().
+  is_facets_stale_ = true;
+  try {
+    delta = controller_.ReloadOBJ(path_.toStdString());
+  } catch (const std::exception& e) {
+    is_facets_stale_ = false;
+    statusBar()->showMessage("Ошибка перезагрузки: " +
+                             QString::fromStdString(e.what()));
+    return;
+  }
+  is_facets_stale_ = false;
+  if (delta.full) {
+    ShowInfo();
+  } else {
+    ui_->openGL->LoadDataToBuffers(delta.vertexes_begin, delta.vertexes_count,
+                                   delta.facets_begin, delta.facets_count);
+    ui_->openGL->update();
+  }
+  ShowReloadStatus();
+}
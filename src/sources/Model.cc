@@ -4,13 +4,133 @@
 
 #include "Model.h"
 
+#include <algorithm>
+#include <charconv>
+#include <clocale>
 #include <cmath>
+#include <cstdlib>
 #include <fstream>
-#include <regex>
+#include <functional>
 #include <sstream>
 
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+
+namespace {
+/**
+ * Chunk boundaries are placed after lines whose hash has the low bits equal
+ * to zero, which gives chunks of about kChunkMask + 1 lines on average.
+ */
+constexpr size_t kChunkMinLines = 16;
+constexpr size_t kChunkMaxLines = 1024;
+constexpr size_t kChunkMask = 63;
+
+bool IsSpace(char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * Returns the next whitespace separated token and removes it from rest.
+ */
+std::string_view NextToken(std::string_view& rest) noexcept {
+  size_t begin = 0;
+  while (begin < rest.size() && IsSpace(rest[begin])) ++begin;
+  size_t end = begin;
+  while (end < rest.size() && !IsSpace(rest[end])) ++end;
+  std::string_view token = rest.substr(begin, end - begin);
+  rest.remove_prefix(end);
+  return token;
+}
+
+/**
+ * Parses a whole token with strtof in the "C" locale, since the application
+ * locale may use a decimal comma. Numbers too small for a float are rounded
+ * to zero or a denormal, and numbers too large become infinite.
+ */
+bool ParseFloatC(const std::string& token, float& value) {
+#if defined(_WIN32)
+  static const _locale_t locale = _create_locale(LC_NUMERIC, "C");
+  const auto parse = [](const char* str, char** end) {
+    return _strtof_l(str, end, locale);
+  };
+#else
+  static const locale_t locale = newlocale(LC_NUMERIC_MASK, "C", nullptr);
+  const auto parse = [](const char* str, char** end) {
+    return strtof_l(str, end, locale);
+  };
+#endif
+  char* end = nullptr;
+  value = parse(token.c_str(), &end);
+  return !token.empty() && end == token.c_str() + token.size() &&
+         std::isfinite(value);
+}
+
+/**
+ * Parses a whole token as a finite number, in fixed or scientific notation.
+ * from_chars is used where the standard library implements it for floats;
+ * it reports numbers too small for a float as out of range, so those go
+ * through strtof.
+ */
+bool ParseFloat(std::string_view token, float& value) {
+  if (!token.empty() && token[0] == '+') {
+    token.remove_prefix(1);
+    if (!token.empty() && (token[0] == '+' || token[0] == '-')) return false;
+  }
+  // strtof also accepts hexadecimal floats, which OBJ does not have.
+  if (token.find_first_of("xX") != std::string_view::npos) return false;
+#if defined(__cpp_lib_to_chars)
+  const char* end = token.data() + token.size();
+  auto [ptr, ec] = std::from_chars(token.data(), end, value);
+  if (ec == std::errc()) return ptr == end && std::isfinite(value);
+  if (ec != std::errc::result_out_of_range) return false;
+#endif
+  return ParseFloatC(std::string(token), value);
+}
+
+/**
+ * Parses the vertex number of a facet item such as "3", "3/1" or "3//2".
+ * An unchecked load accepts trailing garbage after the number.
+ * @return std::errc::invalid_argument for a malformed item and
+ * std::errc::result_out_of_range for a number that does not fit in an int.
+ */
+std::errc ParseIndex(std::string_view item, long& value,
+                     bool strict) noexcept {
+  item = item.substr(0, item.find('/'));
+  if (!item.empty() && item[0] == '+') {
+    item.remove_prefix(1);
+    if (!item.empty() && (item[0] == '+' || item[0] == '-'))
+      return std::errc::invalid_argument;
+  }
+  const char* end = item.data() + item.size();
+  int number = 0;
+  auto [ptr, ec] = std::from_chars(item.data(), end, number);
+  value = number;
+  if (ec == std::errc() && strict && ptr != end)
+    return std::errc::invalid_argument;
+  return ec;
+}
+}  // namespace
+
 void s21::Model::LoadObj(const std::string& path) {
-  obj_ = ObjLoader::GetInstance().Load(path);
+  obj_ = ObjLoader::GetInstance().Load(path, &limits_);
+  scale_ = 1;
+  transformed_ = false;
+}
+s21::ObjDelta s21::Model::ReloadObj(const std::string& path) {
+  if (transformed_) {
+    LoadObj(path);
+    return {};
+  }
+  ObjDelta delta = ObjLoader::GetInstance().Reload(path, obj_, &limits_);
+  if (delta.full) {
+    scale_ = 1;
+    return delta;
+  }
+  auto first = obj_.vertexes.begin() + (long)delta.vertexes_begin;
+  std::for_each(first, first + (long)delta.vertexes_count,
+                [this](float& item) { item = item * scale_; });
+  return delta;
 }
 
 const s21::vertexes_type& s21::Model::Vertexes() const noexcept {
@@ -22,17 +142,23 @@ const s21::facets_type& s21::Model::Facets() const noexcept {
 
 void s21::Model::Scale(float factor) noexcept {
   Affine::GetInstance().Scale(obj_.vertexes, factor);
+  if (factor != 0) scale_ = scale_ * factor;
   NotifyObservers();
 }
 void s21::Model::Rotate(const s21::vertexes_type& corner) noexcept {
   Affine::GetInstance().Rotate(obj_.vertexes, corner);
+  transformed_ = true;
   NotifyObservers();
 }
 void s21::Model::Move(const s21::vertexes_type& offset) noexcept {
   Affine::GetInstance().Move(obj_.vertexes, offset);
+  transformed_ = true;
   NotifyObservers();
 }
 float s21::Model::Max() const noexcept { return obj_.max; }
+const std::vector<s21::ObjError>& s21::Model::Errors() const noexcept {
+  return obj_.errors;
+}
 bool s21::Model::Empty() const noexcept {
   return obj_.facets.empty() || obj_.vertexes.empty();
 }
@@ -41,65 +167,282 @@ s21::ObjLoader& s21::ObjLoader::GetInstance() noexcept {
   static ObjLoader instance;
   return instance;
 }
-s21::Obj s21::ObjLoader::Load(const std::string& path) {
-  Obj obj;
-  obj.max = 0;
+s21::ObjLoadError::ObjLoadError(size_t line, const std::string& message)
+    : std::runtime_error(line == 0 ? message
+                                   : "line " + std::to_string(line) + ": " +
+                                         message),
+      line_(line) {}
+size_t s21::ObjLoadError::Line() const noexcept { return line_; }
+
+s21::Obj s21::ObjLoader::Load(const std::string& path,
+                              const ObjLimits* limits) {
+  std::string data = ReadFile(path, limits);
+  return Parse(data, limits);
+}
+s21::Obj s21::ObjLoader::Parse(std::string_view data,
+                               const ObjLimits* limits) {
+  if (limits != nullptr && data.size() > limits->max_file_size)
+    throw ObjLoadError(0, "file is too large");
+  return ParseAll(SplitChunks(data), limits);
+}
+s21::ObjDelta s21::ObjLoader::Reload(const std::string& path, Obj& obj,
+                                     const ObjLimits* limits) {
+  std::string data = ReadFile(path, limits);
+  return Reparse(data, obj, limits);
+}
+s21::ObjDelta s21::ObjLoader::Reparse(std::string_view data, Obj& obj,
+                                      const ObjLimits* limits) {
+  if (limits != nullptr && data.size() > limits->max_file_size)
+    throw ObjLoadError(0, "file is too large");
+  auto chunks = SplitChunks(data);
+  ObjDelta delta;
+
+  std::vector<size_t> hashes;
+  hashes.reserve(chunks.size());
+  for (const auto& chunk : chunks)
+    hashes.push_back(std::hash<std::string_view>{}(chunk));
+  const size_t common = std::min(obj.chunks.size(), chunks.size());
+  size_t prefix = 0, suffix = 0;
+  while (prefix < common && obj.chunks[prefix].hash == hashes[prefix])
+    ++prefix;
+  while (suffix < common - prefix &&
+         obj.chunks[obj.chunks.size() - 1 - suffix].hash ==
+             hashes[chunks.size() - 1 - suffix])
+    ++suffix;
+  const size_t old_end = obj.chunks.size() - suffix;
+  const size_t new_end = chunks.size() - suffix;
+
+  const auto vertexes_offset = [&obj](size_t i) {
+    return i < obj.chunks.size() ? obj.chunks[i].vertexes_begin
+                                 : obj.vertexes.size();
+  };
+  const auto facets_offset = [&obj](size_t i) {
+    return i < obj.chunks.size() ? obj.chunks[i].facets_begin
+                                 : obj.facets.size();
+  };
+  const size_t vertexes_begin = vertexes_offset(prefix);
+  const size_t facets_begin = facets_offset(prefix);
+  const size_t vertexes_count = vertexes_offset(old_end) - vertexes_begin;
+  const size_t facets_count = facets_offset(old_end) - facets_begin;
+  size_t first_line = 1, old_lines = 0;
+  for (size_t i = 0; i < old_end; ++i)
+    (i < prefix ? first_line : old_lines) += obj.chunks[i].lines;
+
+  Obj patch;
+  patch.max = 0;
+  ParseState state{limits, first_line, vertexes_begin, 0, {}};
+  for (size_t i = prefix; i < new_end; ++i)
+    patch.chunks.push_back(ParseChunk(chunks[i], patch, state));
+  if (patch.vertexes.size() != vertexes_count ||
+      patch.facets.size() != facets_count) {
+    obj = ParseAll(chunks, limits);
+    return delta;
+  }
+
+  float max = 0;
+  const auto update_max = [&max](const ObjChunk& chunk) {
+    if (std::fabs(chunk.max) > std::fabs(max)) max = chunk.max;
+  };
+  std::for_each(obj.chunks.begin(), obj.chunks.begin() + (long)prefix,
+                update_max);
+  std::for_each(patch.chunks.begin(), patch.chunks.end(), update_max);
+  std::for_each(obj.chunks.begin() + (long)old_end, obj.chunks.end(),
+                update_max);
+  if (max != obj.max) {
+    obj = ParseAll(chunks, limits);
+    return delta;
+  }
+
+  // Errors of the replaced lines are replaced too, and errors after them are
+  // moved by the difference in the number of lines. The merged list is
+  // checked before obj changes, as a full load would fail on it.
+  const size_t new_lines = state.line - first_line;
+  auto first_error = std::partition_point(
+      obj.errors.begin(), obj.errors.end(),
+      [first_line](const ObjError& error) { return error.line < first_line; });
+  auto last_error = std::partition_point(
+      first_error, obj.errors.end(),
+      [first_line, old_lines](const ObjError& error) {
+        return error.line < first_line + old_lines;
+      });
+  std::vector<ObjError> errors(obj.errors.begin(), first_error);
+  errors.insert(errors.end(), patch.errors.begin(), patch.errors.end());
+  for (auto it = last_error; it != obj.errors.end(); ++it)
+    errors.push_back({it->line - old_lines + new_lines, it->message});
+  if (limits != nullptr && errors.size() > limits->max_errors)
+    throw ObjLoadError(errors[limits->max_errors].line, "too many errors");
+
+  std::copy(patch.vertexes.begin(), patch.vertexes.end(),
+            obj.vertexes.begin() + (long)vertexes_begin);
+  std::copy(patch.facets.begin(), patch.facets.end(),
+            obj.facets.begin() + (long)facets_begin);
+  for (auto& chunk : patch.chunks) {
+    chunk.vertexes_begin += vertexes_begin;
+    chunk.facets_begin += facets_begin;
+  }
+  obj.chunks.erase(obj.chunks.begin() + (long)prefix,
+                   obj.chunks.begin() + (long)old_end);
+  obj.chunks.insert(obj.chunks.begin() + (long)prefix, patch.chunks.begin(),
+                    patch.chunks.end());
+  obj.errors = std::move(errors);
+
+  delta.full = false;
+  delta.vertexes_begin = vertexes_begin;
+  delta.vertexes_count = vertexes_count;
+  delta.facets_begin = facets_begin;
+  delta.facets_count = facets_count;
+  return delta;
+}
+std::string s21::ObjLoader::ReadFile(const std::string& path,
+                                     const ObjLimits* limits) {
   std::ifstream file;
-  file.open(path);
+  file.open(path, std::ios::binary);
   if (!file.is_open()) throw std::runtime_error("Opening error");
-  std::regex vertex_pattern(R"(\s*v\s+([\d\.-]+)\s+([\d\.-]+)\s+([\d\.-]+))");
-
-  std::string line;
-  while (std::getline(file, line)) {
-    std::smatch match;
-    if (std::regex_match(line, match, vertex_pattern)) {
-      for (size_t i = 1; i < match.size(); ++i) {
-        auto number = std::stof(match[i]);
-        if (abs(number) > abs(obj.max)) obj.max = number;
-        obj.vertexes.push_back(number);
-      }
-    } else if (line[0] == 'f') {
-      auto str_facets = Split(line);
-      facets_type numbers;
-      for (const auto& item : str_facets) {
-        try {
-          numbers.push_back(ExtractNumber(item) - 1);
-        } catch (...) {
-        }
-      }
-      for (size_t i = 1; i < numbers.size(); ++i) {
-        obj.facets.push_back(numbers[i - 1]);
-        obj.facets.push_back(numbers[i]);
-      }
-      if (!numbers.empty()) {
-        obj.facets.push_back(numbers[numbers.size() - 1]);
-        obj.facets.push_back(numbers[0]);
-      }
+  if (limits != nullptr) {
+    file.seekg(0, std::ios::end);
+    if ((size_t)file.tellg() > limits->max_file_size)
+      throw ObjLoadError(0, "file is too large");
+    file.seekg(0, std::ios::beg);
+  }
+  std::stringstream buf;
+  buf << file.rdbuf();
+  return buf.str();
+}
+std::vector<std::string_view> s21::ObjLoader::SplitChunks(
+    std::string_view data) noexcept {
+  std::vector<std::string_view> chunks;
+  size_t begin = 0, pos = 0, lines = 0;
+  while (pos < data.size()) {
+    size_t end = data.find('\n', pos);
+    end = end == std::string_view::npos ? data.size() : end + 1;
+    size_t line_hash =
+        std::hash<std::string_view>{}(data.substr(pos, end - pos));
+    pos = end;
+    ++lines;
+    if ((lines >= kChunkMinLines && (line_hash & kChunkMask) == 0) ||
+        lines >= kChunkMaxLines || pos == data.size()) {
+      chunks.push_back(data.substr(begin, pos - begin));
+      begin = pos;
+      lines = 0;
     }
   }
-  return obj;
+  return chunks;
 }
-std::vector<std::string> s21::ObjLoader::Split(const std::string& s) noexcept {
-  std::vector<std::string> result;
-  std::istringstream iss(s);
-  std::string word;
-
-  while (iss >> word) {
-    result.push_back(word);
+s21::ObjChunk s21::ObjLoader::ParseChunk(std::string_view chunk, Obj& obj,
+                                         ParseState& state) {
+  ObjChunk result{std::hash<std::string_view>{}(chunk),
+                  obj.vertexes.size(),
+                  0,
+                  obj.facets.size(),
+                  0,
+                  0,
+                  0};
+  const float max = state.max;
+  state.max = 0;
+  size_t pos = 0;
+  while (pos < chunk.size()) {
+    size_t end = chunk.find('\n', pos);
+    if (end == std::string_view::npos) end = chunk.size();
+    ParseLine(chunk.substr(pos, end - pos), obj, state);
+    pos = end + 1;
+    ++state.line;
+    ++result.lines;
   }
-
+  result.vertexes_count = obj.vertexes.size() - result.vertexes_begin;
+  result.facets_count = obj.facets.size() - result.facets_begin;
+  result.max = state.max;
+  if (std::fabs(max) >= std::fabs(state.max)) state.max = max;
   return result;
 }
-unsigned s21::ObjLoader::ExtractNumber(const std::string& s) {
-  size_t pos = s.find_first_of('/');
-  std::string numberStr = s.substr(0, pos);
-
-  if (numberStr.empty()) {
-    throw std::invalid_argument(
-        "No number found at the beginning of the string");
+void s21::ObjLoader::ParseLine(std::string_view line, Obj& obj,
+                               ParseState& state) {
+  const ObjLimits* limits = state.limits;
+  std::string_view rest = line;
+  const std::string_view type = NextToken(rest);
+  if (type == "v") {
+    float xyz[3], w;
+    bool is_valid = true;
+    for (float& number : xyz)
+      is_valid = is_valid && ParseFloat(NextToken(rest), number);
+    const std::string_view extra = NextToken(rest);
+    if (is_valid && !extra.empty())
+      is_valid = ParseFloat(extra, w) && NextToken(rest).empty();
+    if (!is_valid && limits == nullptr) return;
+    if (limits != nullptr &&
+        (state.vertexes_before + obj.vertexes.size()) / 3 >=
+            limits->max_vertexes)
+      throw ObjLoadError(state.line, "too many vertexes");
+    if (!is_valid) {
+      // The origin takes the place of the vertex, so that facets keep
+      // referring to the vertices after it.
+      AddError(obj, state, "malformed vertex, replaced by 0 0 0");
+      obj.vertexes.insert(obj.vertexes.end(), 3, 0.0f);
+      return;
+    }
+    for (float number : xyz) {
+      if (std::fabs(number) > std::fabs(state.max)) state.max = number;
+      obj.vertexes.push_back(number);
+    }
+  } else if (type == "f") {
+    const long count =
+        (long)((state.vertexes_before + obj.vertexes.size()) / 3);
+    facets_type& numbers = state.numbers;
+    numbers.clear();
+    for (auto item = NextToken(rest); !item.empty(); item = NextToken(rest)) {
+      long index;
+      const std::errc ec = ParseIndex(item, index, limits != nullptr);
+      if (ec != std::errc()) {
+        if (limits == nullptr) continue;
+        AddError(obj, state,
+                 ec == std::errc::result_out_of_range
+                     ? "facet index " + std::string(item) + " out of range"
+                     : "malformed facet index '" + std::string(item) + "'");
+        return;
+      }
+      if (limits != nullptr) {
+        // Negative indices count back from the last vertex.
+        if (index < 0) index += count + 1;
+        if (index < 1 || index > count) {
+          AddError(obj, state, "facet index " + std::string(item) +
+                                   " out of range");
+          return;
+        }
+        if (numbers.size() == limits->max_facet_vertexes) {
+          AddError(obj, state, "too many vertexes in facet");
+          return;
+        }
+      }
+      numbers.push_back((unsigned)(index - 1));
+    }
+    if (limits != nullptr &&
+        obj.facets.size() + 2 * numbers.size() > limits->max_facets)
+      throw ObjLoadError(state.line, "too many facets");
+    for (size_t i = 1; i < numbers.size(); ++i) {
+      obj.facets.push_back(numbers[i - 1]);
+      obj.facets.push_back(numbers[i]);
+    }
+    if (!numbers.empty()) {
+      obj.facets.push_back(numbers[numbers.size() - 1]);
+      obj.facets.push_back(numbers[0]);
+    }
   }
-
-  return std::stoi(numberStr);
+}
+s21::Obj s21::ObjLoader::ParseAll(const std::vector<std::string_view>& chunks,
+                                  const ObjLimits* limits) {
+  Obj obj;
+  obj.chunks.reserve(chunks.size());
+  ParseState state{limits, 1, 0, 0, {}};
+  for (const auto& chunk : chunks)
+    obj.chunks.push_back(ParseChunk(chunk, obj, state));
+  obj.max = state.max;
+  return obj;
+}
+void s21::ObjLoader::AddError(Obj& obj, const ParseState& state,
+                              std::string message) {
+  if (state.limits == nullptr) return;
+  if (obj.errors.size() == state.limits->max_errors)
+    throw ObjLoadError(state.line, "too many errors");
+  obj.errors.push_back({state.line, std::move(message)});
 }
 
 s21::Affine& s21::Affine::GetInstance() noexcept {
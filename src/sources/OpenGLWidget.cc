@@ -4,23 +4,46 @@
 
 #include "OpenGLWidget.h"
 
-#include <fstream>
 #include <iostream>
-#include <sstream>
-#include <QDir>
+#include <QElapsedTimer>
 #include <QMouseEvent>
 
-#include "config.h"
+namespace {
+/** Number of frames between reports of the average frame CPU time. */
+constexpr qint64 kStatsFrames = 300;
+/** Pause in the input after which full detail is drawn, milliseconds. */
+constexpr int kIdleInterval = 150;
+}  // namespace
 
-OpenGLWidget::OpenGLWidget(QWidget *parent) : QOpenGLWidget(parent) {}
+OpenGLWidget::OpenGLWidget(QWidget *parent)
+    : QOpenGLWidget(parent),
+      is_stats_enabled_(qEnvironmentVariableIsSet("S21_RENDER_STATS")),
+      scheduler_(20, 1u << kLodLevels) {
+  if (qEnvironmentVariableIsSet("S21_INPUT_RECORD"))
+    trace_ = std::make_unique<InputTrace>();
+  connect(this, &QOpenGLWidget::frameSwapped, this,
+          &OpenGLWidget::OnFrameSwapped);
+  idle_timer_.setSingleShot(true);
+  idle_timer_.setInterval(kIdleInterval);
+  connect(&idle_timer_, &QTimer::timeout, this, &OpenGLWidget::OnIdle);
+}
 
 OpenGLWidget::~OpenGLWidget() {
+  if (trace_) trace_->Save(qEnvironmentVariable("S21_INPUT_RECORD"));
+  makeCurrent();
+  render_query_.destroy();
+  pipeline_.Destroy();
   glDeleteVertexArrays(1, &VAO);
+  glDeleteVertexArrays(1, &lod_lines_VAO_);
+  glDeleteVertexArrays(kLodLevels, lod_points_VAOs_);
   glDeleteBuffers(1, &VBO);
   glDeleteBuffers(1, &EBO);
+  glDeleteBuffers(1, &lod_EBO_);
 }
 
 void OpenGLWidget::initializeGL() {
+  QElapsedTimer timer;
+  timer.start();
   initializeOpenGLFunctions();
   model_matrix_.setToIdentity();
   view_matrix_.setToIdentity();
@@ -34,9 +57,14 @@ void OpenGLWidget::initializeGL() {
     projection_matrix_.perspective(45.0f, 1.0f, 0.1f, 100.0f);
   }
   InitBuffers();
-  InitShaderProgram();
+  if (!pipeline_.Init(this)) std::cout << "SHADERS DON'T LINKED" << std::endl;
+  // Without timer queries the render time is measured on the CPU.
+  render_query_.create();
   glEnable(GL_DEPTH_TEST);
   glClearColor(0.784f, 0.823f, 0.819f, 1.0f);
+  if (is_stats_enabled_)
+    std::cout << "initializeGL: " << timer.nsecsElapsed() / 1000 << " us"
+              << std::endl;
 }
 void OpenGLWidget::resizeGL(int w, int h) {
   glViewport(0, 0, w, h);
@@ -45,51 +73,97 @@ void OpenGLWidget::resizeGL(int w, int h) {
     float aspect = (float)w / (float)h;
     projection_matrix_.perspective(45.0f, aspect, 0.1f, 100.0f);
   }
+  scheduler_.Invalidate();
 }
 
 void OpenGLWidget::paintGL() {
+  QElapsedTimer timer;
+  if (is_stats_enabled_) timer.start();
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  ApplyDelta(scheduler_.TakeDelta());
+  TakeRenderTime();
   if (is_data_load_ && vertexes_ != nullptr && facets_ != nullptr) {
-    glUseProgram(shader_program_);
-    glUniformMatrix4fv(glGetUniformLocation(shader_program_, "model"), 1, GL_FALSE,
-                       model_matrix_.constData());
-    glUniformMatrix4fv(glGetUniformLocation(shader_program_, "view"), 1, GL_FALSE,
-                       view_matrix_.constData());
-    glUniformMatrix4fv(glGetUniformLocation(shader_program_, "projection"), 1, GL_FALSE,
-                       projection_matrix_.constData());
-    glBindVertexArray(VAO);
-    if (IsLines() && !facets_->empty())
-      glDrawElements(GL_LINES, (int)facets_->size(), GL_UNSIGNED_INT,
-                     nullptr);
-    if (IsPoints() && !vertexes_->empty())
-      glDrawArrays(GL_POINTS, 0, (int)(vertexes_->size() / 3));
-    glBindVertexArray(0);
-  }
-}
-std::optional<std::string> OpenGLWidget::GetShaderSource(
-    const std::string &filename) {
-  // Try multiple paths for shader files
-  QStringList paths;
-  paths << QDir::currentPath() + "/src/sources/shaders/" + QString::fromStdString(filename);
-  paths << QDir::currentPath() + "/../src/sources/shaders/" + QString::fromStdString(filename);
-  paths << QString(SHADER_PATH) + QString::fromStdString(filename);
-  
-  std::ifstream file;
-  for (const QString& path : paths) {
-    file.open(path.toStdString());
-    if (file.is_open()) break;
+    const unsigned stride = scheduler_.Stride();
+    int level = -1;
+    while ((2u << (level + 1)) <= stride && level + 1 < kLodLevels) ++level;
+    if (level >= 0 && is_lod_stale_) LoadLodBuffers();
+    const bool is_timed =
+        render_query_.isCreated() && !is_render_query_pending_;
+    QElapsedTimer render_timer;
+    if (is_timed)
+      render_query_.begin();
+    else if (!render_query_.isCreated())
+      render_timer.start();
+    pipeline_.Use();
+    pipeline_.SetMatrices(model_matrix_, view_matrix_, projection_matrix_);
+    if (IsLines() && !facets_->empty()) {
+      if (level < 0) {
+        glBindVertexArray(VAO);
+        glDrawElements(GL_LINES, (int)facets_->size(), GL_UNSIGNED_INT,
+                       nullptr);
+      } else {
+        glBindVertexArray(lod_lines_VAO_);
+        glDrawElements(
+            GL_LINES, (int)lod_facets_count_[level], GL_UNSIGNED_INT,
+            (void *)(sizeof(unsigned) * lod_facets_begin_[level]));
+      }
+    }
+    if (IsPoints() && !vertexes_->empty()) {
+      const size_t points_stride = (size_t)1 << (level + 1);
+      glBindVertexArray(level < 0 ? VAO : lod_points_VAOs_[level]);
+      glDrawArrays(GL_POINTS, 0,
+                   (int)((vertexes_->size() / 3 + points_stride - 1) /
+                         points_stride));
+    }
+    if (is_timed) {
+      render_query_.end();
+      is_render_query_pending_ = true;
+      render_query_stride_ = stride;
+    } else if (!render_query_.isCreated()) {
+      scheduler_.RenderMeasured((double)render_timer.nsecsElapsed() / 1e6,
+                                stride);
+    }
   }
-  
-  if (!file.is_open()) {
-    std::cout << "Failed to open shader file: " << filename << std::endl;
-    return std::nullopt;
+  if (is_stats_enabled_) {
+    frames_nsecs_ += timer.nsecsElapsed();
+    if (++frames_ == kStatsFrames) {
+      std::cout << "paintGL: " << frames_nsecs_ / frames_ / 1000
+                << " us per frame" << std::endl;
+      frames_ = 0;
+      frames_nsecs_ = 0;
+    }
   }
-  
-  std::stringstream buf;
-  buf << file.rdbuf();
-  std::string fileData = buf.str();
-  file.close();
-  return fileData;
+}
+
+void OpenGLWidget::OnIdle() {
+  scheduler_.RestoreDetail();
+  if (scheduler_.IsDirty()) update();
+}
+void OpenGLWidget::TakeRenderTime() {
+  // The result of the previous query is read once the GPU has it, so the
+  // frame never waits for it.
+  if (!is_render_query_pending_ || !render_query_.isResultAvailable()) return;
+  is_render_query_pending_ = false;
+  scheduler_.RenderMeasured((double)render_query_.waitForResult() / 1e6,
+                            render_query_stride_);
+}
+void OpenGLWidget::OnFrameSwapped() {
+  // Only the interval between frames drawn back to back is a frame time,
+  // otherwise it includes the idle time before the input.
+  if (is_frame_continuous_)
+    scheduler_.FrameRendered((double)frame_timer_.nsecsElapsed() / 1e6);
+  frame_timer_.start();
+  is_frame_continuous_ = scheduler_.IsDirty();
+  if (is_frame_continuous_) update();
+}
+
+void OpenGLWidget::ApplyDelta(const s21::FrameDelta &delta) {
+  if (delta.y_angle != 0)
+    model_matrix_.rotate(delta.y_angle, QVector3D(0.0f, 1.0f, 0.0f));
+  if (delta.x_angle != 0)
+    model_matrix_.rotate(delta.x_angle, QVector3D(1.0f, 0.0f, 0.0f));
+  if (delta.pan_x != 0 || delta.pan_y != 0)
+    model_matrix_.translate(delta.pan_x, delta.pan_y, 0.0f);
 }
 
 void OpenGLWidget::InitBuffers() {
@@ -102,6 +176,66 @@ void OpenGLWidget::InitBuffers() {
   glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 3,
                         (void *)nullptr);
   glEnableVertexAttribArray(0);
+  glGenBuffers(1, &lod_EBO_);
+  glGenVertexArrays(1, &lod_lines_VAO_);
+  glBindVertexArray(lod_lines_VAO_);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lod_EBO_);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 3,
+                        (void *)nullptr);
+  glEnableVertexAttribArray(0);
+  // The points of a reduced level are every stride-th vertex of the full
+  // vertex buffer, so their arrays only differ by the attribute stride.
+  glGenVertexArrays(kLodLevels, lod_points_VAOs_);
+  for (int level = 0; level < kLodLevels; ++level) {
+    glBindVertexArray(lod_points_VAOs_[level]);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
+                          (GLsizei)(sizeof(GLfloat) * 3 * (2 << level)),
+                          (void *)nullptr);
+    glEnableVertexAttribArray(0);
+  }
+  glBindVertexArray(0);
+}
+void OpenGLWidget::LoadLodBuffers() {
+  // Every level keeps every stride-th edge; the levels are stored one after
+  // another in a single index buffer.
+  std::vector<unsigned> facets;
+  facets.reserve(facets_->size() + 2 * kLodLevels);
+  for (int level = 0; level < kLodLevels; ++level) {
+    lod_facets_begin_[level] = facets.size();
+    const size_t step = (size_t)4 << level;
+    for (size_t i = 0; i + 1 < facets_->size(); i += step) {
+      facets.push_back((*facets_)[i]);
+      facets.push_back((*facets_)[i + 1]);
+    }
+    lod_facets_count_[level] = facets.size() - lod_facets_begin_[level];
+  }
+  glBindVertexArray(lod_lines_VAO_);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, (int)(sizeof(unsigned) * facets.size()),
+               facets.data(), GL_STATIC_DRAW);
+  is_lod_stale_ = false;
+}
+void OpenGLWidget::LoadLodBuffers(size_t facets_begin, size_t facets_count) {
+  // The number of indices is unchanged, so only the kept edges that start
+  // inside the replaced range are copied to each level.
+  if (is_lod_stale_) return;
+  std::vector<unsigned> facets;
+  glBindVertexArray(lod_lines_VAO_);
+  for (int level = 0; level < kLodLevels; ++level) {
+    const size_t step = (size_t)4 << level;
+    const size_t first = (facets_begin + step - 1) / step;
+    const size_t last = (facets_begin + facets_count + step - 1) / step;
+    facets.clear();
+    for (size_t i = first * step; i < last * step && i + 1 < facets_->size();
+         i += step) {
+      facets.push_back((*facets_)[i]);
+      facets.push_back((*facets_)[i + 1]);
+    }
+    if (facets.empty()) continue;
+    glBufferSubData(
+        GL_ELEMENT_ARRAY_BUFFER,
+        (GLintptr)(sizeof(unsigned) * (lod_facets_begin_[level] + 2 * first)),
+        (GLsizeiptr)(sizeof(unsigned) * facets.size()), facets.data());
+  }
   glBindVertexArray(0);
 }
 void OpenGLWidget::LoadDataToBuffers() {
@@ -117,63 +251,70 @@ void OpenGLWidget::LoadDataToBuffers() {
                facets_->data(), GL_STATIC_DRAW);
   glBindVertexArray(0);
   is_data_load_ = true;
+  // The reduced levels are built by the first frame that needs them.
+  is_lod_stale_ = true;
+  scheduler_.Invalidate();
 }
-void OpenGLWidget::InitShaderProgram() {
-  GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-  std::optional<std::string> stringShaderSourcesCode =
-      GetShaderSource("point_vertex");
-  if (!stringShaderSourcesCode) {
-    std::cout << "SHADERS DON'T OPENED" << std::endl;
-    return;
-  }
-  const char *charShaderSourceCode = stringShaderSourcesCode->c_str();
-  glShaderSource(vertexShader, 1, &charShaderSourceCode, nullptr);
-  glCompileShader(vertexShader);
-  GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-  stringShaderSourcesCode = GetShaderSource("point_fragment");
-  if (!stringShaderSourcesCode) {
-    return;
+void OpenGLWidget::LoadVertexesToBuffer() {
+  if (vertexes_ == nullptr || !is_data_load_) return;
+  makeCurrent();
+  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glBufferData(GL_ARRAY_BUFFER, (int)(sizeof(GLfloat) * vertexes_->size()),
+               vertexes_->data(), GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  doneCurrent();
+  scheduler_.Invalidate();
+}
+void OpenGLWidget::LoadDataToBuffers(size_t vertexes_begin,
+                                     size_t vertexes_count,
+                                     size_t facets_begin,
+                                     size_t facets_count) {
+  if (vertexes_ == nullptr || facets_ == nullptr || !is_data_load_) return;
+  makeCurrent();
+  if (vertexes_count != 0) {
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    (GLintptr)(sizeof(GLfloat) * vertexes_begin),
+                    (GLsizeiptr)(sizeof(GLfloat) * vertexes_count),
+                    vertexes_->data() + vertexes_begin);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
   }
-  charShaderSourceCode = stringShaderSourcesCode->c_str();
-  glShaderSource(fragmentShader, 1, &charShaderSourceCode, nullptr);
-  glCompileShader(fragmentShader);
-  shader_program_ = glCreateProgram();
-  glAttachShader(shader_program_, vertexShader);
-  glAttachShader(shader_program_, fragmentShader);
-  glLinkProgram(shader_program_);
-  GLint success;
-  GLchar infoLog[512];
-  glGetProgramiv(shader_program_, GL_LINK_STATUS, &success);
-  if (!success) {
-    glGetProgramInfoLog(shader_program_, 512, nullptr, infoLog);
-    std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-              << infoLog << std::endl;
+  if (facets_count != 0) {
+    glBindVertexArray(VAO);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+                    (GLintptr)(sizeof(unsigned) * facets_begin),
+                    (GLsizeiptr)(sizeof(unsigned) * facets_count),
+                    facets_->data() + facets_begin);
+    glBindVertexArray(0);
+    LoadLodBuffers(facets_begin, facets_count);
   }
-  glDeleteShader(vertexShader);
-  glDeleteShader(fragmentShader);
+  doneCurrent();
+  scheduler_.Invalidate();
 }
-
 void OpenGLWidget::mousePressEvent(QMouseEvent *mouse) {
+  if (trace_) trace_->Record(mouse);
   if (mouse->button() == Qt::LeftButton) {
     is_rotating_ = true;
     mouse_position_ = mouse->pos();
+    scheduler_.BeginInteraction();
   } else if (mouse->button() == Qt::RightButton) {
     is_panning_ = true;
     mouse_position_ = mouse->pos();
+    scheduler_.BeginInteraction();
   }
 }
 
 void OpenGLWidget::mouseMoveEvent(QMouseEvent *mouse) {
+  if (trace_) trace_->Record(mouse);
   if (is_rotating_ && (mouse->buttons() & Qt::LeftButton)) {
     QPoint delta = mouse->pos() - mouse_position_;
     
     float rotation_sensitivity = 0.5f;
     
     float y_angle = delta.x() * rotation_sensitivity;
-    model_matrix_.rotate(y_angle, QVector3D(0.0f, 1.0f, 0.0f));
-    
     float x_angle = delta.y() * rotation_sensitivity;
-    model_matrix_.rotate(x_angle, QVector3D(1.0f, 0.0f, 0.0f));
+    scheduler_.AddRotation(x_angle, y_angle);
+    idle_timer_.start();
     
     mouse_position_ = mouse->pos();
 
@@ -190,7 +331,8 @@ void OpenGLWidget::mouseMoveEvent(QMouseEvent *mouse) {
     float pan_x = normalized_dx * pan_sensitivity * 10.0f;
     float pan_y = normalized_dy * pan_sensitivity * 10.0f;
     
-    model_matrix_.translate(pan_x, pan_y, 0.0f);
+    scheduler_.AddPan(pan_x, pan_y);
+    idle_timer_.start();
     
     mouse_position_ = mouse->pos();
     update();
@@ -198,11 +340,17 @@ void OpenGLWidget::mouseMoveEvent(QMouseEvent *mouse) {
 }
 
 void OpenGLWidget::mouseReleaseEvent(QMouseEvent *mouse) {
+  if (trace_) trace_->Record(mouse);
   if (mouse->button() == Qt::LeftButton) {
     is_rotating_ = false;
   } else if (mouse->button() == Qt::RightButton) {
     is_panning_ = false;
   }
+  if (!is_rotating_ && !is_panning_) {
+    idle_timer_.stop();
+    scheduler_.EndInteraction();
+    if (scheduler_.IsDirty()) update();
+  }
 }
 
 void OpenGLWidget::RotateCoordinateSystem(float angle, const QVector3D &axis) {
@@ -210,7 +358,15 @@ void OpenGLWidget::RotateCoordinateSystem(float angle, const QVector3D &axis) {
   update();
 }
 
-void OpenGLWidget::InitModelMatrix() { model_matrix_.setToIdentity(); }
+void OpenGLWidget::InitModelMatrix() {
+  model_matrix_.setToIdentity();
+  scheduler_.TakeDelta();
+  scheduler_.Invalidate();
+}
+
+const s21::FrameScheduler &OpenGLWidget::Scheduler() const {
+  return scheduler_;
+}
 
 bool OpenGLWidget::IsLines() const { return facets_ != nullptr && !facets_->empty(); }
 bool OpenGLWidget::IsPoints() const { return vertexes_ != nullptr && !vertexes_->empty(); }
@@ -0,0 +1,96 @@
+//
+// Shader program and uniform state of the OpenGL widget.
+//
+
+#include "RenderPipeline.h"
+
+#include <iostream>
+
+#include "Shaders.h"
+
+bool RenderPipeline::Init(QOpenGLExtraFunctions* gl) {
+  gl_ = gl;
+  program_ = LinkProgram();
+  GLuint block = gl_->glGetUniformBlockIndex(program_, "Matrices");
+  const bool success = block != GL_INVALID_INDEX;
+  if (success) gl_->glUniformBlockBinding(program_, block, kMatricesBinding);
+  gl_->glGenBuffers(1, &ubo_);
+  gl_->glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+  gl_->glBufferData(GL_UNIFORM_BUFFER, sizeof(GLfloat) * 16 * 3, nullptr,
+                    GL_DYNAMIC_DRAW);
+  gl_->glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  gl_->glBindBufferBase(GL_UNIFORM_BUFFER, kMatricesBinding, ubo_);
+  is_uploaded_ = false;
+  is_current_ = false;
+  return success;
+}
+
+void RenderPipeline::Destroy() {
+  if (gl_ == nullptr) return;
+  gl_->glDeleteProgram(program_);
+  program_ = 0;
+  gl_->glDeleteBuffers(1, &ubo_);
+  ubo_ = 0;
+  gl_ = nullptr;
+}
+
+void RenderPipeline::SetMatrices(const QMatrix4x4& model,
+                                 const QMatrix4x4& view,
+                                 const QMatrix4x4& projection) {
+  const QMatrix4x4* matrices[3] = {&model, &view, &projection};
+  bool is_bound = false;
+  for (int i = 0; i < 3; ++i) {
+    if (is_uploaded_ && matrices_[i] == *matrices[i]) continue;
+    if (!is_bound) gl_->glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    is_bound = true;
+    matrices_[i] = *matrices[i];
+    gl_->glBufferSubData(GL_UNIFORM_BUFFER,
+                         (GLintptr)(sizeof(GLfloat) * 16 * i),
+                         sizeof(GLfloat) * 16, matrices_[i].constData());
+  }
+  if (is_bound) gl_->glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  is_uploaded_ = true;
+}
+
+void RenderPipeline::Use() {
+  if (is_current_) return;
+  is_current_ = true;
+  gl_->glUseProgram(program_);
+}
+
+GLuint RenderPipeline::CompileShader(GLenum type, const char* source) {
+  GLuint shader = gl_->glCreateShader(type);
+  const char* sources[] = {s21::shaders::kVersion, source};
+  gl_->glShaderSource(shader, 2, sources, nullptr);
+  gl_->glCompileShader(shader);
+  GLint success;
+  GLchar infoLog[512];
+  gl_->glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+  if (!success) {
+    gl_->glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+    std::cout << "ERROR::SHADER::COMPILATION_FAILED\n"
+              << infoLog << std::endl;
+  }
+  return shader;
+}
+
+GLuint RenderPipeline::LinkProgram() {
+  GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, s21::shaders::kVertex);
+  GLuint fragmentShader =
+      CompileShader(GL_FRAGMENT_SHADER, s21::shaders::kFragment);
+  GLuint program = gl_->glCreateProgram();
+  gl_->glAttachShader(program, vertexShader);
+  gl_->glAttachShader(program, fragmentShader);
+  gl_->glLinkProgram(program);
+  GLint success;
+  GLchar infoLog[512];
+  gl_->glGetProgramiv(program, GL_LINK_STATUS, &success);
+  if (!success) {
+    gl_->glGetProgramInfoLog(program, 512, nullptr, infoLog);
+    std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
+              << infoLog << std::endl;
+  }
+  gl_->glDeleteShader(vertexShader);
+  gl_->glDeleteShader(fragmentShader);
+  return program;
+}
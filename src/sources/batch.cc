@@ -0,0 +1,98 @@
+//
+// Command line entry point of the batch tool.
+//
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+
+#include "BatchProcessor.h"
+
+namespace {
+void PrintUsage(const char* name) {
+  std::cerr << "Usage: " << name << " [options] <directory | file.obj>\n"
+            << "  -o <directory>  convert models to the binary mesh format\n"
+            << "  -j <jobs>       number of worker threads\n"
+            << "  -n              normalize models before conversion\n";
+}
+
+void PrintResult(const s21::BatchResult& result) {
+  std::cout << result.path << ": ";
+  if (!result.ok) {
+    std::cout << "FAILED (" << result.error << ")\n";
+    return;
+  }
+  std::cout << (result.issues.empty() ? "OK" : "INVALID") << ", "
+            << result.vertexes << " vertexes, " << result.edges << " edges ("
+            << result.unique_edges << " unique), bbox [" << result.min[0]
+            << ' ' << result.min[1] << ' ' << result.min[2] << "]..["
+            << result.max[0] << ' ' << result.max[1] << ' ' << result.max[2]
+            << "], " << std::fixed << std::setprecision(2)
+            << result.milliseconds << " ms\n"
+            << std::defaultfloat;
+  for (const auto& issue : result.issues)
+    std::cout << "  line " << issue.line << ": " << issue.message << '\n';
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  s21::BatchOptions options;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      options.output = argv[++i];
+    } else if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+      char* end = nullptr;
+      const unsigned long jobs = std::strtoul(argv[++i], &end, 10);
+      if (*end != '\0' || argv[i][0] == '\0' || argv[i][0] == '-' ||
+          jobs > 1024) {
+        PrintUsage(argv[0]);
+        return 2;
+      }
+      options.jobs = (unsigned)jobs;
+    } else if (std::strcmp(argv[i], "-n") == 0) {
+      options.normalize = true;
+    } else if (argv[i][0] != '-' && options.input.empty()) {
+      options.input = argv[i];
+    } else {
+      PrintUsage(argv[0]);
+      return 2;
+    }
+  }
+  if (options.input.empty()) {
+    PrintUsage(argv[0]);
+    return 2;
+  }
+  if (!options.output.empty())
+    std::filesystem::create_directories(options.output);
+
+  const auto begin = std::chrono::steady_clock::now();
+  s21::BatchProcessor processor(options);
+  auto results = processor.Run(PrintResult);
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - begin)
+                             .count();
+
+  size_t failed = 0, invalid = 0, bytes = 0, vertexes = 0;
+  double busy = 0;
+  for (const auto& result : results) {
+    if (!result.ok) ++failed;
+    if (!result.issues.empty()) ++invalid;
+    bytes += result.bytes;
+    vertexes += result.vertexes;
+    busy += result.milliseconds;
+  }
+  const double megabytes = (double)bytes / (1024 * 1024);
+  std::cout << std::fixed << std::setprecision(2) << "\nfiles: "
+            << results.size() << ", failed: " << failed
+            << ", invalid: " << invalid << '\n'
+            << "input: " << megabytes << " MB, " << vertexes
+            << " vertexes\n"
+            << "wall time: " << seconds << " s, cpu time in workers: "
+            << busy / 1000 << " s\n";
+  if (seconds > 0)
+    std::cout << "throughput: " << megabytes / seconds << " MB/s, "
+              << (double)results.size() / seconds << " files/s\n";
+  return failed == 0 && invalid == 0 ? 0 : 1;
+}
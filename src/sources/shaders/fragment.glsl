@@ -1,8 +1,6 @@
-#version 330 core
-
 in vec4 vertex_color;
 out vec4 color;
 void main()
 {
     color = vertex_color;
-}
\ No newline at end of file
+}
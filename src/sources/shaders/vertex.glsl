@@ -1,12 +1,14 @@
-#version 330 core
 layout (location = 0) in vec3 position;
+layout (std140) uniform Matrices
+{
+    mat4 model;
+    mat4 view;
+    mat4 projection;
+};
 out vec4 vertex_color;
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
     gl_Position = projection * view * model * vec4(position, 1.0f);
     vertex_color = vec4(0.0f, 0.478f, 1.0f, 1.0f);
-}
\ No newline at end of file
+}